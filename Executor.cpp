@@ -5,8 +5,10 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "Executor.h"
+#include "Tracer.h"
 
 using namespace std;
 
@@ -14,49 +16,35 @@ using namespace std;
 static vector<int> const_result;
 
 // executes the command in local context and sends back the result
-int *Executor::execute_command(string command, int &count) {
-    // convert command to lowercase first
-    transform(command.begin(), command.end(), command.begin(),
-              [](unsigned char c) { return tolower(c); });
+int *Executor::execute_command(const string &command, int &count) {
+    TraceScope trace(TRACE_EXECUTE);
 
-    stringstream res_str;
-    istringstream string_stream(command);
-
-    string op, sub_op, row_str, row_end_str;
-
-    // split the command into op, sub op and row index strings
-    getline(string_stream, op, ' ');
-    getline(string_stream, sub_op, ' ');
-    getline(string_stream, row_str, '-');
-    getline(string_stream, row_end_str, ' ');
+    // split the command into op, sub op and row index tokens
+    // the tokens are matched case-insensitively so the command is not converted to lowercase
+    const auto tokens = tokenize_command(command.data(), command.length());
 
     // try to parse the row value into integer
-    stringstream row_stream(row_str);
     int row(0);
-    row_stream >> row;
+    const bool row_parsed = parse_int(tokens.row, row);
 
     // try to parse the row end value into integer
-    stringstream row_end_stream(row_end_str);
     int row_end(0);
-    row_end_stream >> row_end;
+    const bool row_end_parsed = parse_int(tokens.row_end, row_end);
 
-    // try to find operator in special operator map keys
-    auto sp_op_element = Executor::special_op_map.find(op);
-    if (sp_op_element != Executor::special_op_map.end()) {
+    // try to find operator in special operators
+    auto sp_op_func = find_special_op(tokens.op);
+    if (sp_op_func != nullptr) {
         // it's a valid special operator so return its result directly
-        return sp_op_element->second(this, count);
+        return sp_op_func(this, count);
     }
 
-    // try to find operator in operator map keys and range operator map keys
-    auto op_element = op_map.find(op);
-    auto range_op_element = range_op_map.find(op);
-
-    if (op_element == op_map.end() && range_op_element == range_op_map.end()) {
+    if (!is_operator(tokens.op)) {
         // operator is not valid
-        res_str << "error: operator \"" << op << "\" is invalid.";
+        stringstream res_str;
+        res_str << "error: operator \"" << to_lower_string(tokens.op) << "\" is invalid.";
         cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-        const_result = vector<int>{-1};
+        const_result.assign(1, -1);
 
         count = const_result.size();
         return const_result.data();
@@ -66,28 +54,28 @@ int *Executor::execute_command(string command, int &count) {
     // we don't call a normal function when there is an invalid row end value
     // and this is another way to check if there was any value passed as a
     // possible row end value
-    if (row_end_str.empty()) {
+    if (tokens.row_end.empty()) {
         // not a range operator call
-        const auto sub_op_map = op_element->second;
-
-        auto sub_op_element = sub_op_map.find(sub_op);
-        if (sub_op_element == sub_op_map.end()) {
+        const auto op_func = find_op(tokens.op, tokens.sub_op);
+        if (op_func == nullptr) {
             // sub-operator is not valid for operator
-            res_str << "error: sub operator \"" << sub_op << "\" is invalid for operator \"" << op << "\".";
+            stringstream res_str;
+            res_str << "error: sub operator \"" << to_lower_string(tokens.sub_op)
+                    << "\" is invalid for operator \"" << to_lower_string(tokens.op) << "\".";
             cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-            const_result = vector<int>{-1};
+            const_result.assign(1, -1);
 
             count = const_result.size();
             return const_result.data();
         }
-        const auto op_func = sub_op_element->second;
 
-        if (row_stream.fail()) {
+        if (!row_parsed) {
+            stringstream res_str;
             res_str << "error: failed to parse row index.";
             cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-            const_result = vector<int>{-1};
+            const_result.assign(1, -1);
 
             count = const_result.size();
             return const_result.data();
@@ -96,36 +84,37 @@ int *Executor::execute_command(string command, int &count) {
         // call the op_func to execute the command
         return op_func(this, row, count);
     } else {
-        const auto range_sub_op_map = range_op_element->second;
-
-        auto range_sub_op_element = range_sub_op_map.find(sub_op);
-        if (range_sub_op_element == range_sub_op_map.end()) {
+        const auto range_op_func = find_range_op(tokens.op, tokens.sub_op);
+        if (range_op_func == nullptr) {
             // sub-operator is not valid for operator
-            res_str << "error: sub operator \"" << sub_op << "\" is invalid for range operator \"" << op << "\".";
+            stringstream res_str;
+            res_str << "error: sub operator \"" << to_lower_string(tokens.sub_op)
+                    << "\" is invalid for range operator \"" << to_lower_string(tokens.op) << "\".";
             cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-            const_result = vector<int>{-1};
+            const_result.assign(1, -1);
 
             count = const_result.size();
             return const_result.data();
         }
-        const auto range_op_func = range_sub_op_element->second;
 
-        if (row_stream.fail()) {
+        if (!row_parsed) {
+            stringstream res_str;
             res_str << "error: failed to parse row index.";
             cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-            const_result = vector<int>{-1};
+            const_result.assign(1, -1);
 
             count = const_result.size();
             return const_result.data();
         }
 
-        if (row_end_stream.fail()) {
+        if (!row_end_parsed) {
+            stringstream res_str;
             res_str << "error: failed to parse row end index.";
             cout << "rank " << this->rank << " >> " << res_str.str() << endl;
 
-            const_result = vector<int>{-1};
+            const_result.assign(1, -1);
 
             count = const_result.size();
             return const_result.data();
@@ -140,44 +129,42 @@ int *Executor::execute_command(string command, int &count) {
 // returns a list of sub commands to send to other ranks in sub_command_map
 P_RESULT Executor::parse_command(const string &command, map<int, pair<int, int>> &sub_command_map,
                                  string &command_prefix) const {
-    istringstream string_stream(command);
-    stringstream prefix_stream;
-
-    string op, sub_op, row_str, row_end_str;
+    TraceScope trace(TRACE_PARSE);
 
-    // split the command into op, sub op and row index strings
-    getline(string_stream, op, ' ');
-    getline(string_stream, sub_op, ' ');
-    getline(string_stream, row_str, '-');
-    getline(string_stream, row_end_str, ' ');
+    // split the command into op, sub op and row index tokens
+    const auto tokens = tokenize_command(command.data(), command.length());
 
-    prefix_stream << op << " " << sub_op << " ";
-    command_prefix = prefix_stream.str();
-
-    if (row_str.substr(0, 3) == "all") {
-        row_str = "0";
-        row_end_str = to_string(this->N);
-    }
+    command_prefix.assign(tokens.op.data, tokens.op.length)
+            .append(1, ' ')
+            .append(tokens.sub_op.data, tokens.sub_op.length)
+            .append(1, ' ');
 
-    // try to parse the row value into integer
-    stringstream row_stream(row_str);
     int row(-3);
-    row_stream >> row;
-
-    // try to parse the row end value into integer
-    stringstream row_end_stream(row_end_str);
     int row_end(-3);
-    row_end_stream >> row_end;
+    bool row_parsed, row_end_parsed;
+    bool is_range = !tokens.row_end.empty();
+
+    // the all keyword is matched case-sensitively, unlike the operators
+    if (tokens.row.length >= 3 && strncmp(tokens.row.data, "all", 3) == 0) {
+        row = 0;
+        row_end = this->N;
+        row_parsed = row_end_parsed = is_range = true;
+    } else {
+        // try to parse the row value and row end value into integer
+        row_parsed = parse_int(tokens.row, row);
+        row_end_parsed = parse_int(tokens.row_end, row_end);
+    }
 
-    if (row_stream.fail()) {
+    if (!row_parsed) {
         // if the operator is empty, ignore
-        if (op.empty()) {
+        if (tokens.op.empty()) {
             return EMPTY_OP;
         }
 
-        // operator is available in special operator map
+        // operator is a special operator
         // it should be sent to all ranks
-        if (Executor::special_op_map.find(op) != Executor::special_op_map.end()) {
+        // only the lowercase form is accepted since the exit checks of the loops are case-sensitive
+        if (find_special_op(tokens.op) != nullptr && is_lowercase(tokens.op)) {
             return SPECIAL_OPERATOR;
         }
 
@@ -191,9 +178,9 @@ P_RESULT Executor::parse_command(const string &command, map<int, pair<int, int>>
         sub_command_map.insert({-1, {row / this->N1, row}});
     }
 
-    if (row_end_str.length() > 0) {
+    if (is_range) {
         // it is a range command
-        if (row_end_stream.fail()) {
+        if (!row_end_parsed) {
             // failed to parse row end
             return ERROR_OPERATOR;
         }
@@ -211,7 +198,7 @@ P_RESULT Executor::parse_command(const string &command, map<int, pair<int, int>>
     }
 
 
-    if (row_end_str.length() > 0) {
+    if (is_range) {
         if (row > row_end) {
             // end_row is non-empty so the range is wrong
             sub_command_map.clear();
@@ -238,14 +225,12 @@ P_RESULT Executor::parse_command(const string &command, map<int, pair<int, int>>
 }
 
 int *Executor::get_row(Executor *executor, int row, int &count) {
-    stringstream res_str;
-
     count = executor->array_part[row].size();
     return executor->array_part[row].data();
 }
 
 int *Executor::get_aggr_range(Executor *executor, int row_start, int row_end, int &count) {
-    stringstream res_str;
+    TraceScope trace(TRACE_AGGR_RANGE);
 
     int aggr = 0;
     for (int row = row_start; row < row_end; ++row) {
@@ -254,7 +239,7 @@ int *Executor::get_aggr_range(Executor *executor, int row_start, int row_end, in
         }
     }
 
-    const_result = vector<int>{aggr};
+    const_result.assign(1, aggr);
 
     count = const_result.size();
     return const_result.data();
@@ -262,14 +247,12 @@ int *Executor::get_aggr_range(Executor *executor, int row_start, int row_end, in
 
 
 int *Executor::get_aggr(Executor *executor, int row, int &count) {
-    stringstream res_str;
-
     int aggr = 0;
     for (const auto &r: executor->array_part[row]) {
         aggr += r;
     }
 
-    const_result = vector<int>{aggr};
+    const_result.assign(1, aggr);
 
     count = const_result.size();
     return const_result.data();
@@ -278,12 +261,55 @@ int *Executor::get_aggr(Executor *executor, int row, int &count) {
 int *Executor::exit(Executor *executor, int &count) {
     count = 1;
     cout << "rank " << executor->rank << " >> exited" << endl;
-    const_result = vector<int>{-1};
+    const_result.assign(1, -1);
 
     count = const_result.size();
     return const_result.data();
 }
 
-map<string, int *(*)(Executor *, int &)> Executor::special_op_map = {
-        {"exit", exit}
-};
+int *Executor::stats(Executor *, int &count) {
+    const_result = Tracer::stats();
+
+    count = const_result.size();
+    return const_result.data();
+}
+
+bool Executor::is_operator(Token op) {
+    switch (command_key(op)) {
+        case command_key("get"):
+            return equals(op, "get");
+        default:
+            return false;
+    }
+}
+
+Executor::op_func_t Executor::find_op(Token op, Token sub_op) {
+    switch (command_key(op, sub_op)) {
+        case command_key("get", "row"):
+            return equals(op, "get") && equals(sub_op, "row") ? get_row : nullptr;
+        case command_key("get", "aggr"):
+            return equals(op, "get") && equals(sub_op, "aggr") ? get_aggr : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+Executor::range_op_func_t Executor::find_range_op(Token op, Token sub_op) {
+    switch (command_key(op, sub_op)) {
+        case command_key("get", "aggr"):
+            return equals(op, "get") && equals(sub_op, "aggr") ? get_aggr_range : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+Executor::special_op_func_t Executor::find_special_op(Token op) {
+    switch (command_key(op)) {
+        case command_key("exit"):
+            return equals(op, "exit") ? exit : nullptr;
+        case command_key("stats"):
+            return equals(op, "stats") ? stats : nullptr;
+        default:
+            return nullptr;
+    }
+}
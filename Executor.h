@@ -9,6 +9,8 @@
 #include <vector>
 #include <map>
 
+#include "Parser.h"
+
 using namespace std;
 
 // enum for the results of the parse function
@@ -23,24 +25,31 @@ enum P_RESULT : int {
 
 class Executor {
 private:
-    // holds the operators, functions and sub operators
-    map<string, map<string,
-            int *(*)(Executor *, int, int &)>> op_map{{
-                                                              "get", {{"row", get_row},
-                                                                      {"aggr", get_aggr}}
-                                                      }};
-    map<string, map<string,
-            int *(*)(Executor *, int, int, int &)>> range_op_map{{
-                                                                         "get", {{"aggr", get_aggr_range}}
-                                                                 }};
-    // holds special functions with only command name (no arguments)
-    static map<string, int *(*)(Executor *, int &)> special_op_map;
+    // function types of the operators, sub operators and special operators
+    typedef int *(*op_func_t)(Executor *, int, int &);
+
+    typedef int *(*range_op_func_t)(Executor *, int, int, int &);
+
+    typedef int *(*special_op_func_t)(Executor *, int &);
+
+    // compile-time dispatch of the operators, sub operators and special functions
+    // with only command name (no arguments), the find functions return nullptr if not found
+    // is_operator returns whether the operator has any sub operator
+    static bool is_operator(Token op);
+
+    static op_func_t find_op(Token op, Token sub_op);
+
+    static range_op_func_t find_range_op(Token op, Token sub_op);
+
+    static special_op_func_t find_special_op(Token op);
 
     // holds the allocated array
     vector<vector<int>> array_part;
 
     static int *exit(Executor *executor, int &);
 
+    static int *stats(Executor *, int &count);
+
 public:
     int rank;
     int N;
@@ -54,7 +63,7 @@ public:
 
     static int *get_aggr_range(Executor *executor, int row_start, int row_end, int &count);
 
-    int *execute_command(string command, int &count);
+    int *execute_command(const string &command, int &count);
 
     P_RESULT parse_command(const string &command, map<int, pair<int, int>> &sub_command_map,
                            string &command_prefix) const;
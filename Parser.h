@@ -0,0 +1,147 @@
+#ifndef MPI_TEST_PARSER_H
+#define MPI_TEST_PARSER_H
+
+#include <climits>
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// span over a part of the command string, the characters are not owned
+struct Token {
+    const char *data;
+    size_t length;
+
+    constexpr Token() : data(""), length(0) {
+    }
+
+    constexpr Token(const char *token_data, size_t token_length) : data(token_data), length(token_length) {
+    }
+
+    // allows string literals to be used as tokens in constant expressions
+    template<size_t N>
+    constexpr Token(const char (&literal)[N]) : data(literal), length(N - 1) {
+    }
+
+    constexpr bool empty() const {
+        return length == 0;
+    }
+};
+
+// the fields of a command: <op> <sub op> <row>[-<row end>]
+struct CommandTokens {
+    Token op;
+    Token sub_op;
+    Token row;
+    Token row_end;
+};
+
+constexpr char to_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? (char) (c - 'A' + 'a') : c;
+}
+
+// case-insensitive comparison of two tokens
+constexpr bool equals(Token a, Token b) {
+    if (a.length != b.length) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a.length; ++i) {
+        if (to_lower(a.data[i]) != to_lower(b.data[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline bool is_lowercase(Token token) {
+    for (size_t i = 0; i < token.length; ++i) {
+        if (to_lower(token.data[i]) != token.data[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline string to_lower_string(Token token) {
+    string result(token.data, token.length);
+    for (auto &c: result) {
+        c = to_lower(c);
+    }
+
+    return result;
+}
+
+// case-insensitive fnv-1a hash of a token, continuing from the given hash
+constexpr unsigned int hash_token(Token token, unsigned int hash = 2166136261u) {
+    for (size_t i = 0; i < token.length; ++i) {
+        hash = (hash ^ (unsigned char) to_lower(token.data[i])) * 16777619u;
+    }
+
+    return hash;
+}
+
+// dispatch key of an operator and sub operator pair, used as switch case labels so that
+// a collision between two known commands is a duplicate case compile error
+constexpr unsigned int command_key(Token op, Token sub_op = Token()) {
+    return hash_token(sub_op, (hash_token(op) ^ ' ') * 16777619u);
+}
+
+// splits the command into its fields in a single pass without copying
+// the row field ends at '-' and may contain spaces, the other fields end at ' '
+inline CommandTokens tokenize_command(const char *data, size_t length) {
+    CommandTokens tokens;
+    Token *fields[] = {&tokens.op, &tokens.sub_op, &tokens.row, &tokens.row_end};
+
+    size_t field = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= length && field < 4; ++i) {
+        if (i == length || data[i] == (field == 2 ? '-' : ' ')) {
+            *fields[field++] = Token(data + start, i - start);
+            start = i + 1;
+        }
+    }
+
+    return tokens;
+}
+
+// parses an integer the same way as reading it from a stream:
+// leading whitespace, an optional sign and at least one digit, trailing characters are ignored
+inline bool parse_int(Token token, int &value) {
+    size_t i = 0;
+    while (i < token.length && (token.data[i] == ' ' || (token.data[i] >= '\t' && token.data[i] <= '\r'))) {
+        i++;
+    }
+
+    bool negative = false;
+    if (i < token.length && (token.data[i] == '-' || token.data[i] == '+')) {
+        negative = token.data[i] == '-';
+        i++;
+    }
+
+    const size_t digits_start = i;
+    long long result = 0;
+    while (i < token.length && token.data[i] >= '0' && token.data[i] <= '9') {
+        result = result * 10 + (token.data[i] - '0');
+        if (result > (long long) INT_MAX + 1) {
+            return false;
+        }
+        i++;
+    }
+
+    if (i == digits_start) {
+        return false;
+    }
+
+    result = negative ? -result : result;
+    if (result > INT_MAX) {
+        return false;
+    }
+
+    value = (int) result;
+    return true;
+}
+
+#endif //MPI_TEST_PARSER_H
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include "Tracer.h"
+
+using namespace std;
+
+// holds the events of one thread
+struct RingBuffer {
+    int id;
+    long long written;
+    struct {
+        T_OP op;
+        long long start;
+        long long end;
+    } events[Tracer::RING_SIZE];
+};
+
+// releases the ring buffer of a thread when it exits so the next thread can reuse it
+struct RingHandle {
+    RingBuffer *ring = nullptr;
+
+    ~RingHandle();
+};
+
+static const char *op_names[TRACE_OP_COUNT] = {
+        "parse_command",
+        "execute_command",
+        "remote_wait",
+        "get_aggr_range",
+        "format_array"
+};
+
+// per operation counters shared by all threads
+static atomic<long long> op_count[TRACE_OP_COUNT];
+static atomic<long long> op_total_ns[TRACE_OP_COUNT];
+static atomic<long long> op_hist[TRACE_OP_COUNT][Tracer::HIST_BUCKETS];
+
+// all ring buffers ever allocated and the ones not owned by a thread
+static mutex ring_mutex;
+static vector<unique_ptr<RingBuffer>> rings;
+static vector<RingBuffer *> free_rings;
+
+static thread_local RingHandle ring_handle;
+
+RingHandle::~RingHandle() {
+    if (ring != nullptr) {
+        lock_guard<mutex> lock(ring_mutex);
+        free_rings.push_back(ring);
+    }
+}
+
+static RingBuffer *acquire_ring() {
+    lock_guard<mutex> lock(ring_mutex);
+
+    if (!free_rings.empty()) {
+        auto ring = free_rings.back();
+        free_rings.pop_back();
+        return ring;
+    }
+
+    rings.emplace_back(new RingBuffer());
+    rings.back()->id = rings.size() - 1;
+    rings.back()->written = 0;
+
+    return rings.back().get();
+}
+
+// formats a duration given in nanoseconds with the largest fitting unit
+static string format_duration(double ns) {
+    stringstream res_stream;
+    res_stream << setprecision(6);
+
+    if (ns < 1e3) {
+        res_stream << ns << " ns";
+    } else if (ns < 1e6) {
+        res_stream << ns / 1e3 << " us";
+    } else if (ns < 1e9) {
+        res_stream << ns / 1e6 << " ms";
+    } else {
+        res_stream << ns / 1e9 << " s";
+    }
+
+    return res_stream.str();
+}
+
+// the counters are sent as int arrays, so each 64-bit counter is split into a high and a low int
+static void push_counter(vector<int> &result, long long counter) {
+    result.push_back((int) (counter >> 32));
+    result.push_back((int) (counter & 0xffffffffLL));
+}
+
+static long long read_counter(vector<int>::const_iterator counter) {
+    return ((long long) counter[0] << 32) | (unsigned int) counter[1];
+}
+
+atomic<bool> Tracer::is_enabled{false};
+
+void Tracer::enable() {
+    is_enabled.store(true, memory_order_relaxed);
+}
+
+long long Tracer::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(T_OP op, long long start, long long end) {
+    const long long duration = end - start;
+
+    // find the log2 bucket of the duration
+    int bucket = 0;
+    while (bucket < HIST_BUCKETS - 1 && (duration >> (bucket + 1)) > 0) {
+        bucket++;
+    }
+
+    op_count[op].fetch_add(1, memory_order_relaxed);
+    op_total_ns[op].fetch_add(duration, memory_order_relaxed);
+    op_hist[op][bucket].fetch_add(1, memory_order_relaxed);
+
+    if (ring_handle.ring == nullptr) {
+        ring_handle.ring = acquire_ring();
+    }
+
+    auto ring = ring_handle.ring;
+    auto &event = ring->events[ring->written % RING_SIZE];
+    event.op = op;
+    event.start = start;
+    event.end = end;
+    ring->written++;
+}
+
+vector<int> Tracer::stats() {
+    vector<int> result{enabled() ? 1 : 0};
+
+    for (int op = 0; op < TRACE_OP_COUNT; ++op) {
+        push_counter(result, op_count[op].load(memory_order_relaxed));
+        push_counter(result, op_total_ns[op].load(memory_order_relaxed));
+        for (int bucket = 0; bucket < HIST_BUCKETS; ++bucket) {
+            push_counter(result, op_hist[op][bucket].load(memory_order_relaxed));
+        }
+    }
+
+    return result;
+}
+
+string Tracer::format_stats(int rank, const vector<int> &stats) {
+    stringstream res_stream;
+
+    if (stats.size() != 1 + TRACE_OP_COUNT * (2 + HIST_BUCKETS) * 2) {
+        res_stream << "rank " << rank << " >> error: invalid stats result.";
+        return res_stream.str();
+    }
+
+    if (stats[0] == 0) {
+        res_stream << "rank " << rank << " >> tracing is disabled (set MPI_TEST_TRACE=1 to enable it).";
+        return res_stream.str();
+    }
+
+    res_stream << "rank " << rank << " >> stats:";
+
+    auto op_stats = stats.begin() + 1;
+    for (int op = 0; op < TRACE_OP_COUNT; ++op, op_stats += (2 + HIST_BUCKETS) * 2) {
+        const long long count = read_counter(op_stats);
+        if (count == 0) {
+            continue;
+        }
+
+        const long long total_ns = read_counter(op_stats + 2);
+        res_stream << endl << "  " << op_names[op] << ": " << count << " calls, total "
+                   << format_duration(total_ns) << ", mean " << format_duration((double) total_ns / count);
+
+        for (int bucket = 0; bucket < HIST_BUCKETS; ++bucket) {
+            const long long bucket_count = read_counter(op_stats + 4 + bucket * 2);
+            if (bucket_count == 0) {
+                continue;
+            }
+
+            // the first bucket also holds 0 ns durations and the last bucket every longer duration
+            if (bucket == 0) {
+                res_stream << endl << "    [0 ns, " << format_duration(2) << "): " << bucket_count;
+            } else if (bucket == HIST_BUCKETS - 1) {
+                res_stream << endl << "    >= " << format_duration(1LL << bucket) << ": " << bucket_count;
+            } else {
+                res_stream << endl << "    [" << format_duration(1LL << bucket) << ", "
+                           << format_duration(1LL << (bucket + 1)) << "): " << bucket_count;
+            }
+        }
+    }
+
+    return res_stream.str();
+}
+
+string Tracer::chrome_trace_events(int rank) {
+    stringstream res_stream;
+    res_stream << fixed << setprecision(3);
+
+    // name the process after the rank so the timeline shows one row per rank
+    res_stream << R"({"name":"process_name","ph":"M","pid":)" << rank
+               << R"(,"args":{"name":"rank )" << rank << R"("}})";
+
+    lock_guard<mutex> lock(ring_mutex);
+
+    for (const auto &ring: rings) {
+        // walk the ring from the oldest event that has not been overwritten
+        const long long first = max(0LL, ring->written - RING_SIZE);
+        for (long long i = first; i < ring->written; ++i) {
+            const auto &event = ring->events[i % RING_SIZE];
+            res_stream << ",\n" << R"({"name":")" << op_names[event.op] << R"(","ph":"X","pid":)" << rank
+                       << R"(,"tid":)" << ring->id
+                       << R"(,"ts":)" << event.start / 1000.0
+                       << R"(,"dur":)" << (event.end - event.start) / 1000.0 << "}";
+        }
+    }
+
+    return res_stream.str();
+}
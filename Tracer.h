@@ -0,0 +1,76 @@
+#ifndef MPI_TEST_TRACER_H
+#define MPI_TEST_TRACER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// enum for the traced hot-path operations
+enum T_OP : int {
+    TRACE_PARSE = 0,
+    TRACE_EXECUTE,
+    TRACE_REMOTE_WAIT,
+    TRACE_AGGR_RANGE,
+    TRACE_FORMAT,
+    TRACE_OP_COUNT
+};
+
+class Tracer {
+private:
+    static atomic<bool> is_enabled;
+
+public:
+    // number of histogram buckets per operation, bucket b holds durations in [2^b, 2^(b+1)) ns,
+    // except bucket 0 which starts at 0 ns and the last bucket which has no upper bound
+    static const int HIST_BUCKETS = 32;
+
+    // number of events kept per thread, the oldest ones are overwritten first
+    static const int RING_SIZE = 4096;
+
+    // enables tracing, must be called before any traced thread is started
+    static void enable();
+
+    static bool enabled() {
+        return is_enabled.load(memory_order_relaxed);
+    }
+
+    // monotonic timestamp in nanoseconds
+    static long long now();
+
+    // adds one event to the counters and to the ring buffer of the calling thread
+    static void record(T_OP op, long long start, long long end);
+
+    // returns the counters of this rank as a flat int array:
+    // { enabled, (count, total ns, HIST_BUCKETS buckets) for every operation }
+    // every counter is stored as a pair of ints (high 32 bits, low 32 bits)
+    static vector<int> stats();
+
+    // formats the flat counters returned by stats() of a rank
+    static string format_stats(int rank, const vector<int> &stats);
+
+    // returns the ring buffer events of this rank as comma separated chrome trace events
+    static string chrome_trace_events(int rank);
+};
+
+// records the lifetime of the scope as an event when tracing is enabled
+class TraceScope {
+private:
+    T_OP op;
+    long long start;
+
+public:
+    explicit TraceScope(T_OP trace_op) :
+            op(trace_op),
+            start(Tracer::enabled() ? Tracer::now() : -1) {
+    }
+
+    ~TraceScope() {
+        if (start >= 0) {
+            Tracer::record(op, start, Tracer::now());
+        }
+    }
+};
+
+#endif //MPI_TEST_TRACER_H
@@ -5,11 +5,17 @@
 #include <sstream>
 #include <future>
 #include <cmath>
+#include <cstdlib>
 
 #include "Executor.h"
+#include "Tracer.h"
 
 using namespace std;
 
+// separate tags so that rank 0 never receives its own command as a result
+static const int COMMAND_TAG = 0;
+static const int RESULT_TAG = 1;
+
 Executor *executor;
 
 vector<string> read_commands(const string &path);
@@ -18,6 +24,8 @@ void mpi_loop();
 
 void validate_and_execute(const string &command, int N, int N1, int rank_count);
 
+void write_chrome_trace(const string &path, int current_rank, int total_rank);
+
 int main(int argc, char **argv) {
     if (argc < 2) {
         cout << "error: total number of rows not specified." << endl;
@@ -74,6 +82,23 @@ int main(int argc, char **argv) {
         N1 = bigN - (total_rank - 1) * N1;
     }
 
+    // enable tracing if requested, the trace file is written when all ranks exit
+    // MPI_TEST_TRACE enables tracing unless it is empty or "0"
+    const char *trace = getenv("MPI_TEST_TRACE");
+    const char *trace_file = getenv("MPI_TEST_TRACE_FILE");
+    const string trace_path = trace_file != nullptr ? trace_file : "";
+
+    // rank 0 decides for all ranks so that every rank makes the same collective calls when writing the trace
+    int trace_flags[2] = {
+            (trace != nullptr && trace[0] != '\0' && string(trace) != "0") || !trace_path.empty(),
+            !trace_path.empty()
+    };
+    MPI_Bcast(trace_flags, 2, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (trace_flags[0]) {
+        Tracer::enable();
+    }
+
     // initialize executor for all ranks including 0
     executor = new Executor(current_rank, bigN, bigM, N1, total_rank);
 
@@ -114,6 +139,10 @@ int main(int argc, char **argv) {
     // wait for mpi loop to exit
     task.wait();
 
+    if (trace_flags[1]) {
+        write_chrome_trace(trace_path, current_rank, total_rank);
+    }
+
     MPI_Finalize();
 
     return 0;
@@ -123,20 +152,22 @@ int main(int argc, char **argv) {
 vector<int> execute_remote_command(int rank, const string &command) {
     // send the command to the target rank
     cout << "rank " << rank << " << " << command << endl;
-    MPI_Send(command.c_str(), command.length(), MPI_CHAR, rank, 0, MPI_COMM_WORLD);
+    MPI_Send(command.c_str(), command.length(), MPI_CHAR, rank, COMMAND_TAG, MPI_COMM_WORLD);
+
+    TraceScope trace(TRACE_REMOTE_WAIT);
 
     int result_len;
     MPI_Status status;
 
     // receive the result length then receive the result value and print it
-    MPI_Probe(rank, 0, MPI_COMM_WORLD, &status);
+    MPI_Probe(rank, RESULT_TAG, MPI_COMM_WORLD, &status);
     MPI_Get_count(&status, MPI_INT, &result_len);
 
 
     vector<int> result;
     result.resize(result_len);
 
-    MPI_Recv(&result[0], result_len, MPI_INT, rank, 0,
+    MPI_Recv(&result[0], result_len, MPI_INT, rank, RESULT_TAG,
              MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
     return result;
@@ -155,6 +186,8 @@ string generate_sub_command(pair<int, int> sub_comm_element, const string& comma
 }
 
 string format_array(const vector<int> &array) {
+    TraceScope trace(TRACE_FORMAT);
+
     stringstream res_stream;
 
     // format as an array e.g.: { 1, 2, ... }
@@ -185,7 +218,11 @@ void validate_and_execute(const string &command, int N, int N1, int rank_count)
     // it should be sent to all ranks
     if (parse_result == SPECIAL_OPERATOR) {
         for (int i = 0; i < rank_count; ++i) {
-            execute_remote_command(i, command);
+            auto result = execute_remote_command(i, command);
+            if (command.substr(0, 5) == "stats") {
+                // print the counters gathered from each rank
+                cout << Tracer::format_stats(i, result) << endl;
+            }
         }
         return;
     }
@@ -286,22 +323,72 @@ void mpi_loop() {
         MPI_Status status;
 
         // receive the command length then receive the command
-        MPI_Probe(0, 0, MPI_COMM_WORLD, &status);
+        MPI_Probe(0, COMMAND_TAG, MPI_COMM_WORLD, &status);
         MPI_Get_count(&status, MPI_CHAR, &command_len);
 
         command.resize(command_len);
 
-        MPI_Recv(&command[0], command_len, MPI_CHAR, 0, 0,
+        MPI_Recv(&command[0], command_len, MPI_CHAR, 0, COMMAND_TAG,
                  MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
         // run the command send the result back
         int count;
         auto result = executor->execute_command(command, count);
 
-        MPI_Send(result, count, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        MPI_Send(result, count, MPI_INT, 0, RESULT_TAG, MPI_COMM_WORLD);
     } while (command.substr(0, 4) != "exit");
 }
 
+// gathers the trace events of all ranks to rank 0 and writes them as a chrome trace json file
+// only the path of rank 0 is used
+void write_chrome_trace(const string &path, int current_rank, int total_rank) {
+    string events = Tracer::chrome_trace_events(current_rank);
+    int events_len = events.length();
+
+    // gather the event lengths first so rank 0 can compute the displacements
+    vector<int> events_lens(total_rank);
+    MPI_Gather(&events_len, 1, MPI_INT, &events_lens[0], 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    vector<int> displacements(total_rank, 0);
+    for (int i = 1; i < total_rank; ++i) {
+        displacements[i] = displacements[i - 1] + events_lens[i - 1];
+    }
+
+    string all_events;
+    if (current_rank == 0) {
+        all_events.resize(displacements[total_rank - 1] + events_lens[total_rank - 1]);
+    }
+
+    MPI_Gatherv(&events[0], events_len, MPI_CHAR, &all_events[0], &events_lens[0], &displacements[0],
+                MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    if (current_rank != 0) {
+        return;
+    }
+
+    ofstream file_stream(path);
+    if (!file_stream) {
+        cout << "error: couldn't open trace file " << path << "." << endl;
+        return;
+    }
+
+    file_stream << "{\"traceEvents\":[\n";
+    for (int i = 0; i < total_rank; ++i) {
+        if (i > 0) {
+            file_stream << ",\n";
+        }
+        file_stream << all_events.substr(displacements[i], events_lens[i]);
+    }
+    file_stream << "\n]}" << endl;
+
+    if (!file_stream) {
+        cout << "error: couldn't write trace file " << path << "." << endl;
+        return;
+    }
+
+    cout << "trace written to " << path << endl;
+}
+
 // reads all commands from file
 vector<string> read_commands(const string &path) {
     ifstream file_stream(path);
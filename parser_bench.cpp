@@ -0,0 +1,116 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Executor.h"
+
+using namespace std;
+
+// counts the heap allocations so the benchmark can show the allocations per command
+static atomic<long long> allocations{0};
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void *ptr = malloc(size)) {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+// runs the function over all commands for the given number of rounds and prints the cost per command
+template<typename F>
+void bench(const string &name, const vector<string> &commands, int rounds, F func) {
+    const long long allocations_start = allocations.load(memory_order_relaxed);
+    const auto start = chrono::steady_clock::now();
+
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto &command: commands) {
+            func(command);
+        }
+    }
+
+    const auto end = chrono::steady_clock::now();
+    const long long total = (long long) rounds * commands.size();
+    const double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+    cout << name << ": " << ns / total << " ns/command, "
+         << (double) (allocations.load(memory_order_relaxed) - allocations_start) / total
+         << " allocations/command" << endl;
+}
+
+int main(int argc, char **argv) {
+    // try to parse the number of rounds from command line
+    int rounds(200000);
+    if (argc > 1) {
+        stringstream rounds_str(argv[1]);
+        rounds_str >> rounds;
+
+        if (rounds_str.fail() || rounds <= 0) {
+            cout << "error: invalid value for rounds." << endl;
+            return 0;
+        }
+    }
+
+    // a single rank holding all rows, so every command can be executed locally
+    // every cell holds the rank value, so the results depend on which function was dispatched
+    const int rank = 1, rows = 100, cols = 8;
+    Executor executor(rank, rows, cols, rows, 2);
+
+    const vector<string> commands{
+            "get row 23",
+            "GET ROW 42",
+            "get aggr 95",
+            "get aggr 10-60",
+            "Get Aggr all",
+            "stats"
+    };
+
+    map<int, pair<int, int>> sub_command_map;
+    string command_prefix;
+    bench("parse_command", commands, rounds, [&](const string &command) {
+        sub_command_map.clear();
+        executor.parse_command(command, sub_command_map, command_prefix);
+    });
+
+    // the worker side never sees "all", it receives the sub commands generated by rank 0
+    const vector<string> sub_commands{
+            "get row 23",
+            "GET ROW 42",
+            "get aggr 95",
+            "get aggr 10-60",
+            "Get Aggr 0-100"
+    };
+
+    // first value of the result of each sub command above
+    const long long expected_per_round = rank + rank + rank * cols + rank * cols * 50 + rank * cols * rows;
+
+    int count;
+    long long checksum = 0;
+    bench("execute_command", sub_commands, rounds, [&](const string &command) {
+        checksum += executor.execute_command(command, count)[0];
+    });
+
+    const long long expected_checksum = expected_per_round * rounds;
+    cout << "checksum: " << checksum << " (expected " << expected_checksum << ")" << endl;
+
+    if (checksum != expected_checksum) {
+        // a command was dispatched to the wrong function or failed
+        cout << "error: checksum mismatch." << endl;
+        return 1;
+    }
+
+    return 0;
+}